@@ -1,27 +1,44 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "db.h"
 // define if debug output wanted
 //#define DEBUGBUF
 
-// declarations for buffer pool hash table
+// declarations for buffer pool hash table.  Entries live inline in
+// one array; file == NULL marks an empty slot.
 struct hashBucket
 {
 	File*	file;    // pointer a file object (more on this below)
 	int	pageNo;  // page number within a file
 	int	frameNo; // frame number of page in the buffer pool
-	hashBucket* 	next;	 // next node in the hash table
 };
 
 
-// hash table to keep track of pages in the buffer pool
+// hash table to keep track of pages in the buffer pool.  Open
+// addressing with linear probing; removal shifts the following
+// entries back instead of leaving tombstones, so lookups never
+// probe further than the longest run of occupied slots.
 class BufHashTbl
 {
 private:
-    int HTSIZE;
-    hashBucket**  ht; // actual hash table
-    int	 hash(const File* file, const int pageNo); // returns value between 0 and HTSIZE-1
+    int HTSIZE;       // number of slots, a power of two
+    int shift;        // 64 - log2(HTSIZE)
+    int numEntries;   // occupied slots
+    hashBucket*  ht;  // actual hash table
+    int	 hash(const File* file, const int pageNo) const; // returns value between 0 and HTSIZE-1
+    void grow();      // double HTSIZE; only needed if the pool grows
 
 public:
     BufHashTbl(const int htSize);  // constructor
@@ -34,7 +51,7 @@ public:
     // Check if (file,pageNo) is currently in the buffer pool (ie. in
     // the hash table).  If so, return corresponding frameNo. else return 
     // HASHNOTFOUND
-  Status lookup(const File* file, const int pageNo, int & frameNo);
+  Status lookup(const File* file, const int pageNo, int & frameNo) const;
 
     // delete entry (file,pageNo) from hash table. REturn OK if page was
     // found.  Else return HASHTBLERROR
@@ -43,18 +60,32 @@ public:
 
 
 class BufMgr;  //forward declaration of BufMgr class 
+class BufPolicy;  // replacement policy, see bufPolicy.h
 
-// class for maintaining information about buffer pool frames
+// page replacement policies the buffer manager can be built with
+enum BufPolicyType { BUF_CLOCK, BUF_LRUK, BUF_2Q, BUF_ARC };
+
+// class for maintaining information about buffer pool frames.
+// file, pageNo, valid and ioInProgress only change while the owning
+// shard is latched exclusively; pinCnt, dirty and refbit are also
+// updated by hits and unpins that hold the latch in shared mode, so
+// they are atomic.
 class BufDesc {
     friend class BufMgr;
+    friend class BufPolicy;
 private:
   File* file;   // pointer to file object
   int   pageNo; // page within file
   int	frameNo;  // frame # of frame
-  int   pinCnt; // number of times this page has been pinned
-  bool 	dirty;	  // true if dirty;  false otherwise
+  atomic<int>  pinCnt; // number of times this page has been pinned
+  atomic<bool> dirty;	  // true if dirty;  false otherwise
   bool 	valid;   // true if page is valid
-  bool  refbit;	 // has this buffer frame been reference recently
+  atomic<bool> refbit;	 // has this buffer frame been reference recently
+  bool  ioInProgress; // page is being read in; pinning must wait
+  atomic<bool> prefetched; // read ahead and not yet asked for
+  atomic<long long> lsn;   // end of the log when last marked dirty;
+                           // the log is synced that far before the
+                           // page is written
 
   void Clear() {  // initialize buffer frame for a new user
     	pinCnt = 0;
@@ -62,6 +93,10 @@ private:
 	pageNo = -1;
     	dirty = false;
 	valid = false;
+	refbit = false;
+	ioInProgress = false;
+	prefetched = false;
+	lsn = 0;
   };
 
   void Set(File* filePtr, int pageNum) { 
@@ -71,71 +106,613 @@ private:
       dirty = false;
       valid = true;
       refbit = true;
+      ioInProgress = false;
+      prefetched = false;
+      lsn = 0;
   }
 
   BufDesc() {
+      frameNo = -1;
       Clear();
   }
 };
 
 
+// Distribution of a value over power-of-two buckets: bucket 0 counts
+// values below 2, bucket b values in [2^b, 2^(b+1)), and the last
+// bucket everything from there on.
+
+const int BUFHISTBUCKETS = 24;
+
+struct BufHistogram
+{
+  int count[BUFHISTBUCKETS];
+
+  static int bucket(const long value)
+    {
+      if (value < 2) return 0;
+      int b = 63 - __builtin_clzl((unsigned long) value);
+      return b < BUFHISTBUCKETS ? b : BUFHISTBUCKETS - 1;
+    }
+
+  // smallest value counted in bucket b
+  static long low(const int b) { return b == 0 ? 0 : 1L << b; }
+
+  void add(const long value) { count[bucket(value)]++; }
+
+  void merge(const BufHistogram & other)
+    {
+      for (int b = 0; b < BUFHISTBUCKETS; b++)
+        count[b] += other.count[b];
+    }
+
+  long total() const
+    {
+      long n = 0;
+      for (int b = 0; b < BUFHISTBUCKETS; b++)
+        n += count[b];
+      return n;
+    }
+
+  // upper bound of the bucket holding fraction p of all values
+  long percentile(const double p) const
+    {
+      long n = total(), seen = 0;
+      for (int b = 0; b < BUFHISTBUCKETS; b++)
+        if ((seen += count[b]) > 0 && seen >= p * n)
+          return (1L << (b + 1)) - 1;
+      return 0;
+    }
+
+  void clear()
+    {
+      for (int b = 0; b < BUFHISTBUCKETS; b++)
+        count[b] = 0;
+    }
+
+  BufHistogram() { clear(); }
+};
+
+
 struct BufStats
 {
-  int accesses;    // Total number of accesses to buffer pool
+  int accesses;    // readPage and allocPage calls
   int diskreads;   // Number of pages read from disk (including allocs)
   int diskwrites;  // Number of pages written back to disk
+  int hits;        // readPage calls that found the page resident
+  int misses;      // readPage calls that had to read the page in
+  int evictions;   // valid pages thrown out by the replacement policy
+  int ghostHits;   // misses on pages the policy still remembered
+  int prefetches;  // pages read ahead of a sequential scan
+  int prefetchHits;  // read-ahead or preloaded pages then asked for
+  int prefetchWaste; // such pages thrown out without being used
+  int ringReuses;  // frames recycled by a BufRing instead of the policy
+  int preloads;    // pages loaded back by a warm restart
+  int mappedReads; // pages read in place from a file's mapping
+  int syncWrites;  // dirty pages a miss had to write out itself
+  int bgWrites;    // dirty pages cleaned by the background writer
+  int writeCalls;  // write requests, one per run, of batched page writes
+  const char* policy; // name of the replacement policy
+  BufHistogram readLatency;  // microseconds per page read
+  BufHistogram writeLatency; // microseconds per write request
+  BufHistogram pinWait;      // microseconds readPage waited for a read
+                             // started by another thread
+  BufHistogram sweepLength;  // frames the policy looked at per victim
 
   void clear()
     {
       accesses = diskreads = diskwrites = 0;
+      hits = misses = evictions = ghostHits = 0;
+      prefetches = prefetchHits = prefetchWaste = ringReuses = 0;
+      preloads = mappedReads = 0;
+      syncWrites = bgWrites = writeCalls = 0;
+      readLatency.clear();
+      writeLatency.clear();
+      pinWait.clear();
+      sweepLength.clear();
+    }
+
+  // fraction of readPage calls served from the pool
+  double hitRatio() const
+    {
+      return hits + misses == 0 ? 0.0 : (double) hits / (hits + misses);
     }
       
   BufStats()
     {
+      policy = "";
       clear();
     }
 };
 
 
+// Buffer pool activity for one file, which for heap files is one
+// relation.  Counters are kept by file name, so they survive the file
+// being closed and opened again.
+
+struct BufFileStats
+{
+  string name;
+  int hits;        // readPage calls that found the page resident
+  int misses;      // readPage calls that had to read the page in
+  int evictions;   // pages of the file thrown out to make room
+  int diskreads;   // pages read in, also by read-ahead
+  int diskwrites;  // dirty pages written back
+
+  double hitRatio() const
+    {
+      return hits + misses == 0 ? 0.0 : (double) hits / (hits + misses);
+    }
+};
+
+// the live counters behind a BufFileStats; hits are counted under
+// the shared shard latch, hence atomic
+struct BufFileCounters
+{
+  atomic<int> hits, misses, evictions, diskreads, diskwrites;
+
+  void clear() { hits = misses = evictions = diskreads = diskwrites = 0; }
+  BufFileCounters() { clear(); }
+};
+
+
+// The pool is split into independently latched shards so that
+// threads touching different pages do not serialize on one latch.
+// A page belongs to shard shardOf(file, pageNo), and shard s owns
+// the frames s, s + numShards, s + 2*numShards, ...  Hits and unpins
+// take the shard latch in shared mode; misses, evictions and flushes
+// take it exclusively.  Disk reads are done with the latch released,
+// with the frame marked ioInProgress so other pinners wait on ioDone.
+
+const int BUFSHARDFRAMES = 64;  // frames per shard when picking a default
+const int BUFMAXSHARDS = 16;    // upper bound on the default shard count
+
+// The pool can be resized while in use (BufMgr::resize).  Address
+// space for BUFMAXFRAMES frames is reserved up front and only the
+// part in use is backed by memory, so pinned pages never move.  The
+// number of shards stays what it was when the pool was created.
+const int BUFMAXFRAMES = 1 << 24;
+
+struct BufShard
+{
+  shared_mutex   latch;         // protects everything below
+  condition_variable_any ioDone; // signalled when a read-in completes
+  BufHashTbl*    hashTable;     // (file, page) -> frame, for this shard
+  BufPolicy*     policy;        // picks victims among the shard's frames
+  int*           freeFrames;    // stack of local indices of invalid frames
+  int            numFree;       // entries on freeFrames
+  int            numFrames;     // number of frames owned by the shard
+  BufStats       stats;         // statistics for this shard
+  atomic<int>    hits;          // hits, counted under the shared latch
+  atomic<int>    prefetchHits;  // likewise for hits on read-ahead pages
+  atomic<int>    mappedReads;   // and for pages read from a mapping
+  // counters of the files with pages in the shard; entries are added
+  // under the exclusive latch and dropped when the file is flushed
+  unordered_map<const File*, BufFileCounters*> files;
+};
+
+
+// Read-ahead.  BufMgr remembers, for the last few files read, the
+// next page of the chain (Page::nextPage) of the page last returned.
+// When a scan asks for exactly that page it is reading sequentially,
+// and a background thread walks the chain ahead of it, reading up
+// to prefetchDepth pages into unpinned frames.
+
+const int BUFSTREAMS = 8;       // files whose access pattern is tracked
+
+struct BufStream
+{
+  const File*    file;          // NULL if the slot is unused
+  int            expected;      // nextPage of the page last read
+  int            run;           // consecutive reads that followed the chain
+};
+
+struct BufPrefetch
+{
+  File*          file;
+  int            pageNo;        // next page to read ahead
+  int            depth;         // pages still to go after this one
+};
+
+
+// A ring is a small set of frames that a big scan, a sort run or a
+// partitioning pass recycles for itself (a buffer access strategy).
+// Pages it reads or allocates on a miss go into the ring's frames;
+// once the ring is full the oldest of them is reused, so the pass
+// does not push the rest of the pool out.  A frame is only reused if
+// it is unpinned and still holds the page the ring put there.  The
+// ring keeps a FIFO per shard since frames belong to shards.
+
+const int BUFRINGFRAMES = 8;    // default ring size
+const int BUFIOPAGES = 8;       // pages per readPages/flushPages call of
+                                // scans and bulk inserts
+
+
+// Background writer.  A thread wakes every few milliseconds, or as
+// soon as a miss had to write a dirty victim itself, and cleans the
+// unpinned dirty frames each shard's policy will evict next.  Pages
+// are copied under the shard latch and stay pinned until written, so
+// they cannot be evicted while clean in the pool but not yet on disk.
+// All writes, also those of flushFile and ~BufMgr, are grouped by
+// file and sorted by page so each run of pages is one request, and
+// the requests of a round are submitted together as one IoBatch.
+
+const int BUFWRITEBATCH = 64;   // pages the writer cleans per round
+const int BUFWRITERMS = 50;     // writer wake-up interval
+
+struct BufWrite
+{
+  File*          file;
+  int            pageNo;
+  const Page*    page;          // contents to write
+  int            frame;         // frame the page came from
+  Status         status;        // result of the write
+};
+
+
+// Warm restart.  When the pool is destroyed the pages it held, and
+// the ones flushFile dropped as their files were closed, are saved
+// hottest first, up to one per frame.  On the next start the list is
+// read back and, as each file in it is opened, a background thread
+// loads the file's pages into free frames in runs of consecutive
+// pages, reading the stretches of a run not yet resident as one
+// IoBatch.  Pages are never evicted to make room.
+
+const int BUFWARMRUN = 32;      // pages per preload batch
+#define BUFWARMFILE "bufwarm"   // where minirel keeps the resident set
+
+struct BufWarmPage
+{
+  string         fileName;
+  int            pageNo;
+};
+
+struct BufWarmJob
+{
+  File*          file;
+  vector<int>    pages;         // sorted page numbers to load
+  unsigned int   next;          // first of pages not yet loaded
+};
+
+
+// Victim cache.  Pages that are evicted, or dropped when their file
+// is closed, can be kept compressed in memory, so that a miss on one
+// of them costs a decompression instead of a read.  A copy is taken
+// out of the cache when its page is read back into the pool, and
+// copies are dropped least recently put first when the cache is
+// full.  Pages that compress to more than 7/8 of their size are not
+// kept.  Copies are kept by file name, so they outlive the closing of
+// their file; they go when the page is freed or the file destroyed.
+
+const int BUFCACHEOVERHEAD = 96; // bytes of bookkeeping per copy
+
+struct BufCacheStats
+{
+  long capacity;   // bytes the cache may use, 0 if there is none
+  long used;       // bytes used now, bookkeeping included
+  int pages;       // copies held now
+  int puts;        // evicted pages offered to the cache
+  int rejects;     // of those, not kept as they did not compress
+  int hits;        // misses served from the cache
+  int misses;      // misses it had no copy for
+  int evictions;   // copies dropped to make room
+  long bytesIn;    // uncompressed size of the copies kept
+  long bytesOut;   // their compressed size
+
+  // how many times smaller the kept copies were
+  double ratio() const
+    {
+      return bytesOut == 0 ? 0.0 : (double) bytesIn / bytesOut;
+    }
+};
+
+class BufCache
+{
+public:
+  BufCache(const long capacity);
+  ~BufCache();
+
+  // keep a compressed copy of the clean page (file, pageNo)
+  void put(const File* file, const int pageNo, const Page* page);
+  // copy (file, pageNo) into page and forget it; false if not held
+  bool get(const File* file, const int pageNo, Page* page);
+  void erase(const File* file, const int pageNo);
+  void eraseFile(const string & fileName);  // for a destroyed file
+
+  const BufCacheStats getStats();
+  void clearStats();
+
+private:
+  typedef pair<string, int> Key;
+  struct Entry
+  {
+    char*        data;          // compressed page
+    int          length;
+    list<Key>::iterator age;    // place in lru
+  };
+
+  map<Key, Entry> entries;      // ordered, so a file's pages are adjacent
+  list<Key>      lru;           // least recently put last
+  mutex          latch;         // protects everything here
+  BufCacheStats  stats;
+
+  void drop(const map<Key, Entry>::iterator it);
+};
+
+class BufRing
+{
+  friend class BufMgr;
+public:
+  ~BufRing();
+
+private:
+  BufRing(const int numShards, const int frames);
+
+  struct Slot
+  {
+    int          frame;         // global frame number
+    const File*  file;          // page the ring put there
+    int          pageNo;
+  };
+
+  int            numShards;
+  int            perShard;      // capacity of each shard's FIFO
+  Slot*          slots;         // perShard slots per shard
+  int*           head;          // oldest slot of each FIFO
+  int*           count;         // slots in use in each FIFO
+};
+
+
 class BufMgr 
 {
 private:
-  unsigned int 	 clockHand;
   int   	 numBufs;    	// Number of pages in buffer pool
-  BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
+  int            numShards;     // Number of shards the pool is split into
+  BufShard*      shards;        // the shards themselves
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
-  BufStats	 bufStats;	// buffer pool statistics
+  int            tableSize;     // entries allocated in bufTable,
+                                // fileNext and filePrev
+  int            maxBufs;       // frames bufPool has address space for
+
+  // shard responsible for (file, pageNo)
+  int shardOf(const File* file, const int pageNo) const;
+
+  // global frame number of local frame i of shard s
+  int shardFrame(const int s, const int i) const
+  {
+	return s + i * numShards;
+  }
+
+  // Frames holding pages of the same file are linked together so that
+  // flushing a file only looks at that file's pages.  The lists are
+  // protected by fileLatch, which is taken after a shard latch.
+  int*           fileNext;      // next frame of the same file, or -1
+  int*           filePrev;      // previous frame of the same file, or -1
+  unordered_map<const File*, int> fileFrames; // file -> first frame
+  mutex          fileLatch;
+
+  // Set/Clear frame and keep the file lists up to date; the frame's
+  // shard must be latched exclusively
+  void setFrame(const int frame, File* file, const int pageNo);
+  void clearFrame(const int frame);
 
-  const Status allocBuf(int & frame);   // allocate a free frame.  
-  const void releaseBuf(int frame); // return unused frame to end of list
-  void advanceClock()
+  // frames currently holding pages of file, grouped by shard
+  void framesOf(const File* file, vector<int> & frames);
+
+  // local index of global frame number frame within its shard
+  int localFrame(const int frame) const
   {
-	clockHand = (clockHand + 1) % numBufs;
+	return frame / numShards;
   }
 
+  // the page held in frame; frames are PAGESIZE bytes apart
+  Page* framePage(const int frame) const
+  {
+	return (Page*)((char*)bufPool + (size_t)frame * PAGESIZE);
+  }
+
+  // allocate a free frame of shard s for (file, pageNo); shard s
+  // must be latched exclusively
+  const Status allocBuf(const int s, const File* file, const int pageNo,
+			int & frame);
+  void releaseBuf(const int s, const int frame); // put invalid frame on
+                                                 // the shard's free list
+
+  // readPage without the read-ahead bookkeeping; prefetchHit tells
+  // whether the page had been read ahead
+  const Status readPageInt(File* file, const int PageNo, Page*& page,
+			   BufRing* ring, bool & prefetchHit);
+  // pin a resident page, returning true on the first hit of a page
+  // that was read ahead
+  bool pinHit(BufShard & shard, const int frameNo);
+
+  // throw the page out of frame, writing it if dirty; shard s must be
+  // latched exclusively
+  const Status evictFrame(const int s, const int frame);
+
+  // get a frame of shard s for (file, pageNo), from ring if it has
+  // one to recycle, else from allocBuf
+  const Status ringAlloc(const int s, BufRing* ring, const File* file,
+			 const int pageNo, int & frame);
+  // remember frame as holding its current page for ring; when the
+  // ring is full its oldest slot is dropped and copied to displaced
+  void ringAdd(const int s, BufRing* ring, const int frame,
+	       BufRing::Slot* displaced = NULL);
+  // make a read-ahead page that a ring scan just used part of the ring
+  void ringAdopt(BufRing* ring, File* file, const int pageNo);
+
+  // read-ahead state, see bufPrefetch.C
+  int            prefetchDepth;  // pages to read ahead, 0 disables
+  BufStream      streams[BUFSTREAMS];
+  int            nextStream;     // slot to reuse for a new stream
+  deque<BufPrefetch> prefetchQueue;
+  mutex          prefetchLatch;  // protects the three above
+  condition_variable prefetchReady; // signalled when work is queued
+  mutex          prefetchIoLatch; // held while a page is being read ahead
+  thread*        prefetcher;     // the read-ahead thread, if started
+  bool           stopPrefetcher;
+
+  // note that page was just returned for (file, pageNo)
+  void noteAccess(File* file, const int pageNo, const Page* page);
+  void prefetchLoop();
+  // read pageNo of file ahead if needed; returns false to stop the walk
+  bool prefetchPage(File* file, const int pageNo, int & nextPageNo);
+  // drop queued read-ahead for file and wait for one in flight
+  void cancelPrefetch(const File* file);
+
+  BufCache*      victimCache;    // compressed copies of evicted pages
+  // read pageNo of file into frame from the victim cache, or failing
+  // that the file; cached tells which.  No latch may be held.
+  const Status fillFrame(File* file, const int pageNo, const int frame,
+                         bool & cached);
+
+  // warm restart state, see bufWarm.C
+  string         warmFileName;   // where the resident set is saved
+  map<string, vector<int> > warmPages; // saved pages of files not yet
+                                 // opened, by file name
+  deque<BufWarmPage> departed;   // pages flushFile dropped, latest first
+  deque<BufWarmJob> warmQueue;   // files being preloaded
+  mutex          warmLatch;      // protects the four above
+  condition_variable warmReady;  // signalled when a file is queued
+  thread*        warmer;         // the preload thread, if started
+  bool           stopWarmer;
+
+  void warmLoop();
+  // load pages[0..n) of file, which are consecutive, into free frames
+  void warmRun(File* file, const int* pages, const int n);
+  // remember the pages of file that flushFile is about to drop
+  void noteDeparted(const File* file, const vector<int> & pageNos);
+  void saveWarmSet();
+
+  // background writer state, see bufWriter.C
+  thread*        writer;         // the writer thread, if started
+  bool           stopWriter;
+  int            writerInterval; // ms between rounds
+  mutex          writerLatch;    // protects stopWriter
+  condition_variable writerWake; // signalled on a synchronous write
+  mutex          writerIoLatch;  // held by the writer for a round and
+                                 // by flushFile, which must not race it
+  Page*          writeBuf;       // page copies for one round
+  BufWrite*      writeList;      // the round's writes
+  int*           victimList;     // scratch for BufPolicy::nextVictims
+
+  // statistics kept outside the shards, protected by statsLatch
+  mutex          statsLatch;
+  BufHistogram   writeLatency;   // write calls of every kind
+  map<string, BufFileCounters*> fileStats; // by file name
+
+  // counters for file in shard, created if need be; the shard latch
+  // must be held exclusively
+  BufFileCounters* countersFor(BufShard & shard, const File* file);
+  // the same under the shared latch; NULL if there are none yet
+  BufFileCounters* countersOf(BufShard & shard, const File* file) const;
+  void noteWrite(const long micros);
+
+  // page-aligned memory for n pages, on huge pages when it is big
+  // enough; bytes is set to the size to hand back to unmapPages
+  static Page* mapPages(const int n, size_t & bytes, bool & huge);
+  static void unmapPages(Page* pages, const size_t bytes);
+  size_t         writeBufBytes;  // size of the mapping behind writeBuf
+
+  // back frames [from, to) of bufPool with memory, or give it back
+  void commitPool(const int from, const int to);
+  void decommitPool(const int from, const int to);
+
+  // resize helpers, see bufResize.C; all shard latches are held
+  void growTable(const int bufs);
+  const Status vacateShard(const int s, const int keep);
+  void movePage(const int s, const int from, const int to);
+  void rebuildFreeList(const int s, const int frames);
+
+  void writerLoop();
+  int cleanRound();              // returns pages written
+  // write n pages, sorted and coalesced into runs per file; sets the
+  // status of each entry and returns the number of requests made
+  int writeRuns(BufWrite* writes, const int n);
+
 
 public:
   Page*	         bufPool;   // actual buffer pool
 
-  BufMgr(const int bufs);
+  // shards == 0 picks one shard per BUFSHARDFRAMES frames
+  BufMgr(const int bufs, const BufPolicyType policy = BUF_CLOCK,
+         const int shards = 0);
   ~BufMgr();
 
-  const Status readPage(File* file, const int PageNo, Page*& page);
+  // ring, if given, supplies the frame on a miss
+  const Status readPage(File* file, const int PageNo, Page*& page,
+                        BufRing* ring = NULL);
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
-  const Status allocPage(File* file, int& PageNo, Page*& page); 
+
+  // readPage for a caller that only reads the page.  A page of a
+  // mapped file that is not in the pool is not read in but returned
+  // from the mapping, with mapped set; it must not be changed or
+  // unpinned, and stays valid while the file is open.  Pages in the
+  // pool, which may be newer than the file, are pinned as usual.
+  const Status readPageMapped(File* file, const int PageNo, Page*& page,
+                              bool & mapped, BufRing* ring = NULL);
+  const Status allocPage(File* file, int& PageNo, Page*& page,
+                         BufRing* ring = NULL);
                         // allocates a new, empty page 
+
+  // Bring count consecutive pages of file, from firstPage up to the
+  // end of the file, into the pool without pinning them.  Pages not
+  // yet resident are read with one vectored request per stretch of
+  // them, all submitted together; ring, if given, supplies the frames.
+  // The pages count as read ahead until readPage asks for them.
+  const Status readPages(File* file, const int firstPage, const int count,
+                         BufRing* ring = NULL);
+  // Write out the dirty, unpinned pages of file among the count from
+  // firstPage on, one request per run of consecutive pages.  They stay
+  // in the pool, clean.
+  const Status flushPages(File* file, const int firstPage, const int count);
+  // Write out every dirty page of file, pinned or not, leaving them in
+  // the pool.  For checkpoints, taken between statements.
+  const Status cleanFile(const File* file);
+
+  // a ring of frames for a big scan or write pass; delete it when done
+  BufRing* newRing(const int frames = BUFRINGFRAMES);
+  int numBuffers() const { return numBufs; }
+
+  // grow or shrink the pool to bufs frames.  Resident pages are kept
+  // where room allows; when shrinking, pages in frames that go move
+  // to free frames or to ones the policy evicts.  Fails with
+  // PAGEPINNED if a frame that would go holds a pinned page.
+  const Status resize(const int bufs);
   const Status flushFile(const File* file); // writing out all dirty pages of the file
+  const Status discardFile(const File* file); // drop the pages of a file being
+                                              // destroyed without writing them
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
   void  printSelf();
 
-  const BufStats & getBufStats() const // get buffer pool usage
-  {
-	return bufStats;
-  }
-  const void clearBufStats() 
-  {
-	bufStats.clear();
-  }
+  // number of pages read ahead of a sequential scan; 0 turns
+  // read-ahead off (the default)
+  void setPrefetchDepth(const int depth);
+
+  // save the resident set in fileName when the pool is destroyed,
+  // and load the set saved there last time back in the background
+  // as the files in it are opened
+  const Status warmRestart(const string & fileName);
+  // called by DB when it opens a file that was not open
+  void fileOpened(File* file);
+
+  // keep compressed copies of evicted pages in up to bytes of memory;
+  // 0 turns the victim cache off.  Only to be called while no pages
+  // are being read.
+  void setVictimCache(const long bytes);
+  const BufCacheStats getCacheStats();
+
+  // called by DB before it destroys a file; the victim cache and the
+  // replacement policies forget its pages
+  void fileDestroyed(const string & fileName);
+
+  // start the background writer, waking every intervalMs
+  void startWriter(const int intervalMs = BUFWRITERMS);
+
+  const BufStats getBufStats(); // get buffer pool usage, summed over shards
+  const void clearBufStats();
+  // per-file usage, ordered by file name
+  void getFileStats(vector<BufFileStats> & files);
 };
 
 #endif
@@ -0,0 +1,312 @@
+#ifndef BUFPOLICY_H
+#define BUFPOLICY_H
+
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "page.h"
+#include "buf.h"
+
+// Page replacement policies for the buffer manager.
+//
+// Every shard of the pool owns one policy object, which sees the
+// shard's frames by their local index 0..numFrames-1. The buffer
+// manager keeps free (invalid) frames on its own free list, so a
+// policy only ever tracks frames that hold a page:
+//
+//   admit()  - a page was just loaded into a frame; counts a ghost
+//              hit in stats if the policy still remembered it
+//   touch()  - a resident page was pinned again (a hit)
+//   remove() - a frame was emptied without going through victim()
+//   victim() - pick an unpinned frame to evict and stop tracking it;
+//              (file, pageNo) is the page about to be admitted.
+//              Returns -1 when every tracked frame is pinned.  The
+//              number of frames looked at goes to stats.sweepLength.
+//   restore() - the page in frame, just returned by victim(), could
+//              not be evicted after all; track it again where it was,
+//              forgetting its ghost.  What victim() learned from the
+//              page about to be admitted is kept.
+//   nextVictims() - list up to max tracked frames, pinned or not, in
+//              the order victim() would look at them, without changing
+//              anything; the background writer cleans these first
+//   resize() - the shard now has numFrames frames described by
+//              bufTable; when it shrinks, the frames that go are no
+//              longer tracked
+//   forgetFile() - the file of that name was destroyed; pages of a new
+//              file of the name are not the ones remembered
+//
+// touch() is called with the shard latch held in shared mode, the
+// rest with it held exclusively, so policies that keep lists take
+// their own mutex.
+
+class BufPolicy
+{
+public:
+  BufPolicy(BufDesc* bufTable, const int shard, const int stride,
+            const int numFrames);
+  virtual ~BufPolicy() {}
+
+  virtual const char* name() const = 0;
+  virtual void admit(const int frame, const File* file, const int pageNo,
+                     BufStats & stats) = 0;
+  virtual void touch(const int frame) = 0;
+  virtual void remove(const int frame) = 0;
+  virtual int victim(const File* file, const int pageNo, BufStats & stats) = 0;
+  virtual void restore(const int frame) = 0;
+  virtual int nextVictims(int* frames, const int max) = 0;
+  virtual void resize(BufDesc* bufTable, const int numFrames);
+  virtual void forgetFile(const string & fileName) {}
+
+  // build the policy selected by type for one shard
+  static BufPolicy* create(const BufPolicyType type, BufDesc* bufTable,
+                           const int shard, const int stride,
+                           const int numFrames);
+
+  // map a policy name ("clock", "lru2", "2q", "arc") to its type
+  static const Status parse(const char* name, BufPolicyType & type);
+
+protected:
+  BufDesc* bufTable;  // the buffer manager's frame descriptors
+  int shard;          // frame i of this policy is bufTable[shard + i*stride]
+  int stride;
+  int numFrames;      // frames owned by the shard
+
+  bool pinned(const int i) const
+  {
+    return bufTable[shard + i * stride].pinCnt > 0;
+  }
+  bool referenced(const int i) const
+  {
+    return bufTable[shard + i * stride].refbit;
+  }
+  void clearRef(const int i) { bufTable[shard + i * stride].refbit = false; }
+};
+
+
+// (file, pageNo) of a page that is no longer resident, remembered by
+// LRU-K, 2Q and ARC to recognise pages coming back.  The file is kept
+// by name, as in BufCache: a File object goes when the file is closed,
+// and a later one may be given its address.
+struct BufGhostKey
+{
+  string file;
+  int pageNo;
+
+  BufGhostKey() : pageNo(0) {}
+  BufGhostKey(const File* file, const int pageNo)
+    : file(file->name()), pageNo(pageNo) {}
+
+  bool operator==(const BufGhostKey & other) const
+  {
+    return pageNo == other.pageNo && file == other.file;
+  }
+};
+
+struct BufGhostHash
+{
+  size_t operator()(const BufGhostKey & key) const
+  {
+    return hash<string>()(key.file) * 0x9E3779B97F4A7C15UL + key.pageNo;
+  }
+};
+
+// FIFO of ghost keys with O(1) membership test and removal.
+class BufGhostList
+{
+public:
+  bool contains(const BufGhostKey & key) const;
+  void pushFront(const BufGhostKey & key);
+  void erase(const BufGhostKey & key);
+  void popBack();
+  void eraseFile(const string & fileName);   // every key of the file
+  const BufGhostKey & back() const { return keys.back(); }
+  int size() const { return (int)keys.size(); }
+
+private:
+  list<BufGhostKey> keys;  // most recent first
+  unordered_map<BufGhostKey, list<BufGhostKey>::iterator, BufGhostHash> where;
+};
+
+// Doubly linked list of the local frames of one shard, threaded
+// through arrays so that moving a frame never allocates.
+class BufFrameList
+{
+public:
+  BufFrameList(const int numFrames);
+  ~BufFrameList();
+
+  void pushFront(const int i);
+  void pushBack(const int i);
+  void erase(const int i);
+  bool contains(const int i) const { return in[i]; }
+  int front() const { return head; }
+  int back() const { return tail; }
+  int prevOf(const int i) const { return prev[i]; }
+  int size() const { return count; }
+  // room for numFrames frames; frames that go must not be listed
+  void resize(const int numFrames);
+
+private:
+  int* prev;
+  int* next;
+  bool* in;
+  int capacity;
+  int head, tail, count;
+};
+
+
+// The original second-chance clock over BufDesc::refbit.
+class ClockPolicy : public BufPolicy
+{
+public:
+  ClockPolicy(BufDesc* bufTable, const int shard, const int stride,
+              const int numFrames);
+  ~ClockPolicy();
+
+  const char* name() const { return "clock"; }
+  void admit(const int frame, const File* file, const int pageNo,
+             BufStats & stats);
+  void touch(const int frame) {}
+  void remove(const int frame);
+  int victim(const File* file, const int pageNo, BufStats & stats);
+  void restore(const int frame);
+  int nextVictims(int* frames, const int max);
+  void resize(BufDesc* bufTable, const int numFrames);
+
+private:
+  unsigned int clockHand;  // local index of the last frame looked at
+  bool* tracked;           // frame holds a page this policy may evict
+};
+
+
+// LRU-K (O'Neil, O'Neil and Weikum): evict the page whose K-th most
+// recent reference is oldest.  Pages with fewer than K references
+// go first, in LRU order.  Reference history is kept for a while
+// after a page is evicted so that a page that comes back is not
+// treated as cold again.
+class LRUKPolicy : public BufPolicy
+{
+public:
+  LRUKPolicy(BufDesc* bufTable, const int shard, const int stride,
+             const int numFrames, const int k = 2);
+  ~LRUKPolicy();
+
+  const char* name() const { return "lru2"; }
+  void admit(const int frame, const File* file, const int pageNo,
+             BufStats & stats);
+  void touch(const int frame);
+  void remove(const int frame);
+  int victim(const File* file, const int pageNo, BufStats & stats);
+  void restore(const int frame);
+  int nextVictims(int* frames, const int max);
+  void resize(BufDesc* bufTable, const int numFrames);
+  void forgetFile(const string & fileName);
+
+private:
+  struct Order  // eviction order of a resident frame
+  {
+    unsigned long kth;   // time of K-th most recent reference, 0 if none
+    unsigned long last;  // time of most recent reference
+    int frame;
+    bool operator<(const Order & o) const
+    {
+      if (kth != o.kth) return kth < o.kth;
+      if (last != o.last) return last < o.last;
+      return frame < o.frame;
+    }
+  };
+
+  Order orderOf(const int frame) const;
+  void reference(const int frame);
+
+  mutex latch;
+  int k;
+  unsigned long clock;       // logical time, bumped on every reference
+  unsigned long* history;    // k reference times per frame, newest first
+  BufGhostKey* keys;         // page held by each frame
+  bool* tracked;
+  set<Order> order;          // tracked frames, oldest K-distance first
+
+  // history of recently evicted pages
+  unordered_map<BufGhostKey, vector<unsigned long>, BufGhostHash> ghostHistory;
+  BufGhostList ghosts;
+};
+
+
+// 2Q (Johnson and Shasha).  New pages enter the FIFO A1in; pages
+// evicted from A1in are remembered in the ghost FIFO A1out, and a
+// page found there on a miss goes straight to the LRU list Am.  A
+// single sequential scan therefore only churns A1in.
+class TwoQPolicy : public BufPolicy
+{
+public:
+  TwoQPolicy(BufDesc* bufTable, const int shard, const int stride,
+             const int numFrames);
+
+  const char* name() const { return "2q"; }
+  void admit(const int frame, const File* file, const int pageNo,
+             BufStats & stats);
+  void touch(const int frame);
+  void remove(const int frame);
+  int victim(const File* file, const int pageNo, BufStats & stats);
+  void restore(const int frame);
+  int nextVictims(int* frames, const int max);
+  void resize(BufDesc* bufTable, const int numFrames);
+  void forgetFile(const string & fileName);
+
+private:
+  int evictFrom(BufFrameList & list, const bool remember, int & scanned);
+
+  mutex latch;
+  int kin;                 // target size of A1in
+  int kout;                // size of A1out
+  BufFrameList a1in;
+  BufFrameList am;
+  BufGhostList a1out;
+  vector<BufGhostKey> keys; // page held by each frame
+};
+
+
+// ARC (Megiddo and Modha).  T1 holds pages seen once recently, T2
+// pages seen at least twice; B1 and B2 remember what was evicted
+// from each.  A miss that hits B1 grows the share of T1 (the target
+// p), a miss that hits B2 shrinks it, so the split between recency
+// and frequency adapts to the workload.
+class ARCPolicy : public BufPolicy
+{
+public:
+  ARCPolicy(BufDesc* bufTable, const int shard, const int stride,
+            const int numFrames);
+
+  const char* name() const { return "arc"; }
+  void admit(const int frame, const File* file, const int pageNo,
+             BufStats & stats);
+  void touch(const int frame);
+  void remove(const int frame);
+  int victim(const File* file, const int pageNo, BufStats & stats);
+  void restore(const int frame);
+  int nextVictims(int* frames, const int max);
+  void resize(BufDesc* bufTable, const int numFrames);
+  void forgetFile(const string & fileName);
+
+private:
+  int adapt(const BufGhostKey & key);
+  int evictFrom(BufFrameList & list, BufGhostList & ghost, int & scanned);
+
+  mutex latch;
+  int p;                   // target size of T1
+  BufFrameList t1;
+  BufFrameList t2;
+  BufGhostList b1;
+  BufGhostList b2;
+  vector<BufGhostKey> keys; // page held by each frame
+
+  // victim() adapts p for the page about to come in; admit() must
+  // not do it a second time
+  BufGhostKey pending;
+  int pendingGhost;        // 0: none, 1: key was in B1, 2: in B2
+  bool havePending;
+};
+
+#endif
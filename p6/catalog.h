@@ -48,10 +48,15 @@ class RelCatalog : public HeapFile {
   // remove tuple from catalog
   const Status removeInfo(const string & relation);
 
-  // create a new relation
+  // create a new relation, its pages in the given layout.  Its
+  // records all have the same length, so they go on fixed pages
+  // unless another layout is asked for.  The pages of a relation
+  // made with compress set are compressed on disk.
   const Status createRel(const string & relation, 
 		   const int attrCnt, 
-		   const attrInfo attrList[]);
+		   const attrInfo attrList[],
+		   const PageLayout layout = FIXEDLAYOUT,
+		   const bool compress = false);
 
   // destroy a relation
   const Status destroyRel(const string & relation);
@@ -115,7 +120,9 @@ class AttrCatalog : public HeapFile {
 extern RelCatalog  *relCat;
 extern AttrCatalog *attrCat;
 extern Error error;
-extern Status createHeapFile(const string filename);
+extern Status createHeapFile(const string filename,
+                             const Page* format = NULL,
+                             const bool compress = false);
 extern Status destroyHeapFile(const string filename);
 
 #endif
@@ -2,7 +2,11 @@
 #define DB_H
 
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <functional>
+#include <list>
+#include <mutex>
+#include <vector>
 #include "error.h"
 #include <string.h>
 using namespace std;
@@ -15,10 +19,48 @@ using namespace std;
 // forward class definition for db
 class DB;
 
+// buffers and offsets of O_DIRECT transfers must be multiples of this
+const unsigned DIRECTALIGN = 512;
+
+// files grow by this many pages at a time unless DB::setExtentSize
+// says otherwise
+const int DEFAULTEXTENT = 16;
+
+// the pages of a compressed file are kept in slots of whole units of
+// this many bytes
+const int COMPRESSUNIT = 64;
+
+// at most this many files are kept open with no users unless
+// DB::setOpenFileCache says otherwise
+const int DEFAULTOPENFILES = 32;
+
+// The format of the files made now.  Files of any other, including
+// those made before the format was kept, whose pages have their
+// header at the end, are refused with BADFORMAT.
+const int DBFORMAT = 1;
+
+// structure of DB (header) page
+
+typedef struct {
+  int nextFree;                         // page # of next page on free list
+  int firstPage;                        // page # of first page in file
+  int numPages;                         // total # of pages in file
+  int pageSize;                         // page size
+  int format;                           // DBFORMAT, 0 in files made
+                                        // before it was kept
+  int compressUnit;                     // slot unit of a compressed
+                                        // file, 0 if not compressed
+  int mapStart;                         // unit where the page map of a
+                                        // compressed file starts
+  int mapLength;                        // bytes in the page map
+} DBPage;
+
 // class definition for open files
 class File {
   friend class DB;
   friend class OpenFileHashTbl;
+  friend class IoBatch;
+  friend class Wal;
 
  public:
 
@@ -28,7 +70,24 @@ class File {
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status writePages(const int pageNo, const int count,
+		   const Page* const* pages); // write count consecutive pages
+  const Status readPages(const int pageNo, const int count,
+		   Page* const* pages) const; // read count consecutive pages
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
+  const string & name() const { return fileName; }  // name of the file
+  int pageCount() const { return header.numPages; } // header page included
+  bool compressed() const { return header.compressUnit != 0; }
+
+  // pageNo as it is on disk, read in place from the file's mapping,
+  // or NULL if the file is not mapped or the page lies beyond what
+  // was mapped when the file was opened
+  const Page* mappedPage(const int pageNo) const
+    {
+      if (pageNo < 1 || pageNo >= mapPages || pageNo >= header.numPages)
+        return NULL;
+      return (const Page*)(mapBase + (size_t)pageNo * PAGESIZE);
+    }
 
   bool operator == (const File & other) const
     {
@@ -40,16 +99,46 @@ class File {
   File(const string &fname);                   // initialize
   ~File();                  // deallocate file object
 
-  static const Status create(const string &fileName);
+  static const Status create(const string &fileName,
+                             const bool compress);
   static const Status destroy(const string &fileName);
 
-  const Status open();
+  const Status open(const bool directIO = false,
+                    const int extent = DEFAULTEXTENT,
+                    const bool mapped = false);
   const Status close();
+  void map();                           // map the pages allocated so far
+
+  const Status extend();                // preallocate the next extent
+  const Status writeHeader();           // write back the cached header
+  const Status sync();                  // header and pages to stable storage
 
   const Status intread(const int pageNo,
 		 Page* pagePtr) const;        // internal file read
   const Status intwrite(const int pageNo,
 		  const Page* pagePtr);       // internal file write
+  const Status intwritev(const int pageNo, const int count,
+		  const Page* const* pages);  // internal vectored write
+  const Status intreadv(const int pageNo, const int count,
+		  Page* const* pages) const;  // internal vectored read
+  ssize_t transfer(const bool write, const int pageNo,
+                   const struct iovec* iov,
+                   const int iovcnt) const;   // one request to the backend
+  ssize_t transferAt(const bool write, const off_t offset,
+                     const struct iovec* iov,
+                     const int iovcnt) const; // the same at a byte offset
+  bool bounced(const Page* const* pages,
+               const int count) const;  // buffers O_DIRECT cannot take
+  bool directFailed(const int err) const; // leave O_DIRECT after EINVAL
+
+  // compressed files
+  const Status readMap();               // load the page map, find free units
+  const Status writeMap();              // write the page map elsewhere
+  int takeUnits(const int units);       // first unit of a free run
+  void freeUnits(const int start, int units);
+  const Status readPacked(const int pageNo, const int count,
+                          Page* const* pages) const;
+  const Status writePacked(const int pageNo, const Page* pagePtr);
 
 #ifdef DEBUGFREE
   void listFree();                      // list free pages
@@ -58,6 +147,46 @@ class File {
   string fileName;                    // The name of the file
   int openCnt;                        // # times file has been opened
   int unixFile;                       // unix file stream for file
+  mutable bool direct;                // opened with O_DIRECT
+
+  // A file stays open, with openCnt 0 and its dirty pages in the
+  // buffer pool, after its last user closes it, until DB needs the
+  // room for another (see DB::closeFile).  idleAt is its place in
+  // DB's list of such files.
+  bool logged;                        // has records in the log
+  list<File*>::iterator idleAt;       // valid while openCnt is 0
+
+  // The header page is read when the file is opened and written back
+  // when it is closed.  Pages are allocated extentPages at a time;
+  // pages numPages..allocated-1 exist on disk but are not yet in use.
+  DBPage header;                      // cached header page
+  bool headerDirty;                   // header changed since written
+  int allocated;                      // pages the file has room for
+  int extentPages;                    // pages added by extend()
+
+  // A mapped file is also mapped read-only into memory, as far as it
+  // went when opened or last taken back from DB's idle files, for
+  // mappedPage().  Writes never use the mapping.
+  char* mapBase;                      // NULL if not mapped
+  int mapPages;                       // pages covered by the mapping
+
+  // The pages of a compressed file are not at pageNo * PAGESIZE but
+  // in slots of whole compressUnits, wherever there was room, and the
+  // page map says where.  A page is written back to its slot when it
+  // still fits and moved otherwise.  The map is written to a new place
+  // with the header, which says where it is, so the slots pages moved
+  // from are held in moved until then: the map on disk may still send
+  // readers there.  compressLatch guards the map and the free runs.
+  struct Extent {
+    int start;                        // first unit, 0 if never written
+    int units;                        // length of the slot
+  };
+  vector<Extent> extents;             // page map, by page number
+  vector<vector<int> > freeRuns;      // free runs, by length in units
+  vector<Extent> moved;               // slots to free with the header
+  int endUnit;                        // units in use at the end
+  bool mapDirty;                      // extents changed since written
+  mutable mutex compressLatch;
 };
 
 class BufMgr;
@@ -94,32 +223,74 @@ public:
 
     // returns OK if fileName was found.  Else return HASHTBLERROR
     Status erase(const string fileName);
+
+    // append every open file to files
+    void list(vector<File*> & files) const;
 };
 
 
+struct DBStats {
+  int opens;                            // files opened from disk
+  int reuses;                           // opens of a file kept open
+  int evictions;                        // files closed to make room
+  int idle;                             // files kept open now
+};
+
 
 class DB {
  public:
   DB();                                 // initialize open file table
   ~DB();                                // clean up any remaining open files
 
-  const Status createFile(const string & fileName) ;  // create a new file
+  // create a new file, its pages compressed on disk if compress is set
+  const Status createFile(const string & fileName,
+                          const bool compress = false);
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
   const Status openFile(const string & fileName, File* & file);  // open a file
   const Status closeFile(File* file);         // close a file
 
+  // return the page size of the database fileName belongs to, read
+  // from the file's header page; the file need not be open
+  const Status getPageSize(const string & fileName, unsigned & size);
+
+  // open files from now on with O_DIRECT, bypassing the OS page
+  // cache; falls back to normal I/O where the file system refuses it,
+  // and for compressed files, whose slots are not aligned
+  void setDirectIO(const bool on) { directIO = on; }
+
+  // map files opened from now on into memory, so that scans can read
+  // their pages in place instead of copying them into the buffer
+  // pool; files opened with O_DIRECT, or compressed, are not mapped
+  void setMappedReads(const bool on) { mappedReads = on; }
+
+  // grow files opened from now on pages pages at a time
+  void setExtentSize(const int pages)
+    { extentPages = pages > 0 ? pages : 1; }
+
+  // keep up to files files open after they are closed, 0 for none
+  void setOpenFileCache(const int files);
+
+  // Write the dirty pages of every open file and sync the files.
+  // Called by Wal::checkpoint between statements.
+  const Status checkpoint();
+
+  // close every file kept open; done before the buffer manager goes
+  const Status closeIdle();
+
+  const DBStats getStats() const;
+
  private:
+  const Status release(File* file);     // close a file kept open
+
   OpenFileHashTbl   openFiles;    // list of open files
+  list<File*>       idle;         // files kept open, last closed first
+  int               idleMax;      // most files kept open
+  DBStats           stats;
+  bool              directIO;     // open files with O_DIRECT
+  int               extentPages;  // pages files grow by
+  bool              mappedReads;  // map files for reading
 };
 
 
-// structure of DB (header) page
-
-typedef struct {
-  int nextFree;                         // page # of next page on free list
-  int firstPage;                        // page # of first page in file
-  int numPages;                         // total # of pages in file
-} DBPage;
-
 #endif
@@ -17,12 +17,13 @@ enum Status {
 // File and DB errors
 
        BADFILEPTR, BADFILE, FILETABFULL, FILEOPEN, FILENOTOPEN,
-       UNIXERR, BADPAGEPTR, BADPAGENO, FILEEXISTS,
+       UNIXERR, BADPAGEPTR, BADPAGENO, FILEEXISTS, BADPAGESIZE,
+       BADIOBACKEND, BADLOG, BADPAGEDATA, BADFORMAT,
 
 // BufMgr and HashTable errors
 
        HASHTBLERROR, HASHNOTFOUND, BUFFEREXCEEDED, PAGENOTPINNED,
-       BADBUFFER, PAGEPINNED,
+       BADBUFFER, PAGEPINNED, BADBUFPOLICY, BADBUFSIZE,
 
 // Page errors
 	
@@ -45,7 +46,7 @@ enum Status {
 
        BADCATPARM, RELNOTFOUND, ATTRNOTFOUND,
        NAMETOOLONG, DUPLATTR, RELEXISTS, NOINDEX,
-       INDEXEXISTS, ATTRTOOLONG,
+       INDEXEXISTS, ATTRTOOLONG, BADLAYOUT,
 
 // Utility errors
 
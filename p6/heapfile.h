@@ -24,6 +24,14 @@ const unsigned MAXNAMESIZE = 50;
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
 
+// The rest of the header page holds the file's free-space map: a
+// stack of data pages that deletes have left with room for another
+// record.  A page is pushed when a delete first gives it room for a
+// record as long as the deleted one, and inserts take pages from the
+// top before they allocate a new page.  Entries can go stale, since
+// inserts may fill a page while it is on the stack; a page found too
+// full is popped.  When the stack is full, further pages are left off.
+
 struct FileHdrPage
 {
   char		fileName[MAXNAMESIZE];   // name of file
@@ -31,8 +39,14 @@ struct FileHdrPage
   int		lastPage;	// pageNo of last data page in file
   int		pageCnt;	// number of pages
   int		recCnt;		// record count
+  int		freeCnt;	// number of pages in freePages
+  int		freePages[MAXPAGESIZE / sizeof(int)];
+                                // free-space map, to the end of the page
 };
 
+// number of pages the free-space map of a header page can hold
+const int freeMapSize();
+
 
 // class definition of heapFile
 class HeapFile {
@@ -45,8 +59,32 @@ protected:
    Page* 	curPage;	// data page currently pinned in buffer pool
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
+   bool		curMapped;      // page is read in place from the file's
+                                // mapping and not pinned
    RID   	curRec;         // rid of last record returned
 
+   BufRing*	ring;           // frames data pages are read into, or NULL
+   bool		ownRing;        // ring was made by this object
+
+   char*	gather;         // PAGESIZE bytes the records of PAX pages
+                                // are put together in, or NULL
+
+   // read rid off the current page, in place if the page keeps it
+   // whole and into gather if not
+   const Status readRecord(const RID & rid, Record & rec);
+
+   // unpin the current page, if it is pinned
+   const Status releaseCurPage();
+
+   // push pageNo on the free-space map
+   void addFreePage(const int pageNo);
+
+   // insert rec into the current page, logging the change
+   const Status insertIntoPage(const Record & rec, RID & rid);
+   // log the counts of the header page as they are now, imaging the
+   // page first if it has not been since the last checkpoint
+   void logHeader();
+
 public:
 
   // initialize
@@ -60,6 +98,11 @@ public:
 
   // given a RID, read record from file, returning pointer and length
   const Status getRecord(const RID &rid, Record & rec);
+
+  // read and allocate data pages through ring from now on, so that
+  // a big pass over the file does not flush the buffer pool.  The
+  // caller keeps ownership of ring, which may be shared by files.
+  void useRing(BufRing* ring);
 };
 
 
@@ -88,10 +131,18 @@ public:
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
+    // read length bytes at offset of the current record, returning a
+    // pointer to them; cheaper than getRecord when the relation's
+    // pages have the PAX layout, since only those bytes are read
+    const Status getField(const int offset, const int length,
+                          const char* & field);
+
     // delete current record 
     const Status deleteRecord();
 
-    // marks current page of scan dirty
+    // marks current page of scan dirty.  Pages of a mapped file are
+    // read in place and must not be changed, so call this before
+    // changing the current record, and get the record again.
     const Status markDirty();
 
 private:
@@ -101,6 +152,12 @@ private:
     const char* filter;      // comparison value of filter
     Operator op;             // comparison operator of filter
 
+    // where the filter attribute is on a PAX page, found once a page
+    const Page* columnPage;  // page it was found on, or NULL
+    int   columnPageNo;
+    const char* column;      // NULL if not on a PAX page
+    int   columnStride;
+
      // The following variables are used to preserve the state
     // of the scan when the method markScan() is invoked.
     // A subsequent invocation of resetScan() will cause the
@@ -108,7 +165,15 @@ private:
     int   markedPageNo;	// page number of pinned page
     RID   markedRec;         // rid of last record returned
 
-    const bool matchRec(const Record & rec) const;
+    // pages readFrom..readTo-1 were last brought in by readPages
+    int   readFrom;
+    int   readTo;
+
+    const bool matchRec();              // current record matches
+
+    // read the pages from pageNo on into the pool several at a time,
+    // unless the last readPages covered pageNo
+    void readAhead(const int pageNo);
 };
 
 
@@ -123,6 +188,12 @@ public:
 
     // insert record into file, returning its RID
     const Status insertRecord(const Record & rec, RID& outRid); 
+
+private:
+    int   flushFrom;         // first page not written by flushPages
+
+    // make pageNo the current page, read into the pool for writing
+    const Status switchPage(const int pageNo);
 };
 
 #endif
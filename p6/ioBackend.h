@@ -0,0 +1,116 @@
+#ifndef IOBACKEND_H
+#define IOBACKEND_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+#include "error.h"
+#include "page.h"
+#include "db.h"
+
+// I/O backends for database files.
+//
+// A backend carries out requests, each one transfer between a run of
+// consecutive bytes of a file and a list of buffers.  submit() starts
+// requests and complete() waits for them, so a caller can keep up to
+// IOQUEUEDEPTH of them in flight at once:
+//
+//   posix    - pread/pwrite, or preadv/pwritev for several buffers;
+//              submit() does the transfers itself, one call each
+//   io_uring - requests are queued on a ring shared with the kernel,
+//              which works on all of them at once; one io_uring_enter
+//              call submits a batch and another collects completions.
+//              A request performed on its own is done with a plain
+//              pread/pwrite, which is cheaper when nothing overlaps it
+//
+// Every thread has a backend of its own, so none of this is latched.
+// Where the kernel does not allow io_uring the posix backend is used.
+
+enum IoBackendType { IO_POSIX, IO_URING };
+
+const int IOQUEUEDEPTH = 64;    // most requests in flight per thread
+
+struct IoRequest {
+  int fd;
+  bool write;
+  off_t offset;
+  const struct iovec* iov;
+  int iovcnt;
+  ssize_t result;               // bytes transferred, or -errno
+};
+
+class IoBackend
+{
+ public:
+  virtual ~IoBackend() {}
+  virtual const char* name() const = 0;
+
+  // Start reqs[0..n) and return how many of them, from the first,
+  // were started.  They must stay where they are until complete()
+  // hands them back, and no more than IOQUEUEDEPTH may be in flight.
+  virtual int submit(IoRequest* const* reqs, const int n) = 0;
+
+  // Wait until at least min requests have completed, store up to max
+  // of them in done and return how many were stored.
+  virtual int complete(IoRequest** done, const int min, const int max) = 0;
+
+  // Run req alone and wait for it; returns req.result.
+  virtual ssize_t perform(IoRequest & req);
+
+  // the calling thread's backend, of the type last set
+  static IoBackend* get();
+
+  // Choose the backend for I/O from now on.  Each thread switches
+  // at its next request, when it has none in flight.
+  static void setType(const IoBackendType type);
+
+  // map a backend name ("posix", "uring") to its type
+  static const Status parse(const char* name, IoBackendType & type);
+};
+
+
+// Page transfers on any number of files, carried out together.  Add
+// runs of consecutive pages with read() and write(), then start()
+// submits them and finish() waits for all of them, keeping the
+// backend's queue full meanwhile.  The page pointers and status of a
+// run must stay valid until finish() returns; status is set to OK or
+// to the first error of the run.
+
+class IoBatch
+{
+ public:
+  IoBatch() : started(0), inFlight(0) {}
+
+  void read(const File* file, const int pageNo, const int count,
+            Page* const* pages, Status* status);
+  void write(File* file, const int pageNo, const int count,
+             const Page* const* pages, Status* status);
+
+  void start();
+  int finish();                 // returns the number of requests made
+
+ private:
+  struct Run {
+    const File* file;
+    bool write;
+    int pageNo;
+    int count;
+    const Page* const* pages;
+    Status* status;
+  };
+
+  void add(const Run & run);
+  void prepare();
+  void fill();
+  void done(IoRequest* req);
+
+  vector<Run> runs;
+  vector<IoRequest> reqs;       // built by prepare(), several per long run
+  vector<int> owner;            // index in runs of each request
+  vector<struct iovec> iovs;
+  unsigned int started;         // requests submitted so far
+  int inFlight;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef LZ_H
+#define LZ_H
+
+// A small LZ77 compressor for pages.  Input is coded as a series of
+// sequences, each a run of literal bytes followed by a copy of
+// earlier output:
+//
+//   token    high 4 bits literal count, low 4 bits match length - 4;
+//            a nibble of 15 is continued in the following bytes,
+//            each adding up to 255, until a byte below 255
+//   literals
+//   offset   2 bytes, little endian: how far back the copy starts
+//
+// The last sequence has literals only.  Runs of the same byte, such
+// as the zero padding of string attributes, become copies from one
+// byte back and shrink to a few bytes.
+
+const int LZMINMATCH = 4;       // shortest copy that is coded
+
+// Compress n bytes at src into dst, which has room for cap bytes.
+// Returns the compressed length, or -1 if it would not fit.
+int lzCompress(const char* src, const int n, char* dst, const int cap);
+
+// Decompress the n bytes at src, which must expand to exactly len
+// bytes, into dst.  Returns false if the data is corrupt.
+bool lzDecompress(const char* src, const int n, char* dst, const int len);
+
+#endif
@@ -22,31 +22,128 @@ struct slot_t {
         short	length;  // equals -1 if slot is not in use
 };
 
-const unsigned PAGESIZE = 1024;
+// The page size is chosen per database when it is created and is
+// kept on the header page of each of its files.  PAGESIZE holds the
+// size of the database in use; it is set with setPageSize before the
+// buffer manager is created and not changed while one exists.
+
+const unsigned MINPAGESIZE = 1024;
+const unsigned MAXPAGESIZE = 16384;
+const unsigned DEFAULTPAGESIZE = 1024;
+extern unsigned PAGESIZE;
+
+// make size, a power of two from MINPAGESIZE to MAXPAGESIZE, the
+// page size; returns BADPAGESIZE for any other size
+const Status setPageSize(const unsigned size);
+
+// Empty slots below slotCnt are kept on a list threaded through
+// their offset fields, each holding 1 + the slot number of the next
+// one (0 ends the list), so that insertRecord takes one without
+// walking the slot array.  freeSlot holds SLOTLIST + 1 + the number of
+// the first, or just SLOTLIST if there is none.  Pages written before
+// there was a list have anything there; one whose freeSlot does not
+// carry the SLOTLIST tag, or whose list turns out not to lead to an
+// empty slot, has its list rebuilt from the slot array.
+const short SLOTLIST = 0x5000;
+const short SLOTMASK = 0x0fff;          // more than a page has slots
+
+// How a page keeps its records.  Pages of a row layout keep each
+// record whole and can hold records of any length.  A PAX page (see
+// pagePax.C) holds records of one length, all of the same attributes,
+// and keeps the values of each attribute together in a minipage of its
+// own, so that a scan looking at a few attributes of a wide relation
+// reads those and nothing else.  A fixed page holds records of one
+// length too, whole and one after the other, and finds them by slot
+// number alone.  Every page of a heap file has the layout its first
+// page was given.
+enum PageLayout { ROWLAYOUT, PAXLAYOUT, FIXEDLAYOUT };
+
+struct PaxDir;                          // see pagePax.C
+struct PaxAttr;
+
 const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
-const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
+#define PAGEDATASIZE (PAGESIZE-DPFIXED+sizeof(slot_t))
 // size of the data area of a page
 
 // Class definition for a minirel data page.   
-// The design assumes that records are kept compacted when
-// deletions are performed. Notice, however, that the slot
-// array cannot be compacted.  Notice, this class does not keep
+// Deleting a record leaves a hole, counted in freeSpace; the
+// records are compacted only when an insert needs the room or the
+// page is let go of dirty (see compact).  Notice, however, that the
+// slot array cannot be compacted.  Notice, this class does not keep
 // the records align, relying instead on upper levels to take
 // care of non-aligned attributes
+//
+// Only the first PAGESIZE bytes of a Page exist: pages live in
+// PAGESIZE-byte frames, so a Page is never copied or sized with
+// sizeof.  The header comes first and the slot array ends the page.
+//
+// PAX and fixed pages have no slot array: their slotCnt holds the
+// number of records they have room for, which is what tells them from
+// a row page, whose slotCnt is never positive.  Their slot numbers
+// count up from 0.
 
 class Page {
 private:
-    char 	data[PAGESIZE - DPFIXED]; 
-    slot_t 	slot[1]; // first element of slot array - grows backwards!
     short	slotCnt; // number of slots in use;
     short	freePtr; // offset of first free byte in data[]
     short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    short	freeSlot; // first empty slot, see SLOTLIST
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
+    char 	data[MAXPAGESIZE - DPFIXED + sizeof(slot_t)];
+                         // records, then the slot array
+
+    // first element of slot array - grows backwards!
+    slot_t* slotArray() const
+      { return (slot_t*)&data[PAGESIZE - DPFIXED]; }
+
+    int takeFreeSlot();     // index of an empty slot, or slotCnt if none
+    void linkFreeSlots();   // rebuild the list of empty slots
+    int gap() const;        // bytes free after the last record
+
+    // PAX and fixed pages, in pagePax.C
+    PaxDir* paxDir() const { return (PaxDir*)data; }
+    PaxAttr* paxAttrs() const;
+    int dirSize() const;                // bytes of PaxDir and PaxAttrs
+    unsigned char* paxBitmap() const;   // a bit for each slot in use
+    bool paxUsed(const int slotNo) const;
+    int paxLength(const int slotNo) const;  // 0 if slotNo is empty
+    int paxFind(const int slotNo, const bool used) const;
+                            // first slot from slotNo on in use (or
+                            // empty), -1 if none
+    void paxClear();                    // empty the page
+    void paxFree();                     // set freeSpace from the count
+    const Status paxInsert(const Record & rec, RID& rid);
+    const Status paxDelete(const RID & rid);
+    const Status paxGather(const RID & rid, Record & rec, char* buf) const;
+    const char* paxField(const RID & rid, const int offset,
+                         const int length) const;
+    const char* paxColumn(const int offset, const int length,
+                          int& stride) const;
+    void paxDump() const;
 
 public:
     void init(const int pageNo); // initialize a new page
+
+    // initialize a new, empty PAX page for records of attrCnt
+    // attributes of the given lengths, in that order; returns
+    // INVALIDRECLEN if not even one record would fit
+    const Status initPax(const int pageNo, const int attrCnt,
+                         const int lengths[]);
+
+    // initialize a new, empty fixed page for records of recLen bytes;
+    // returns INVALIDRECLEN if not even one would fit
+    const Status initFixed(const int pageNo, const int recLen);
+
+    // initialize a new, empty page of model's layout.  Only the first
+    // model->formatBytes() bytes of model are read.
+    void initLike(const int pageNo, const Page* model);
+
+    // bytes at the start of the page that initLike needs of a model
+    // page, 0 for a page of the row layout
+    int formatBytes() const;
+
+    PageLayout layout() const;
     void dumpPage() const;       // dump contents of a page
 
     const Status getNextPage(int& pageNo) const; // returns value of nextPage
@@ -59,6 +156,10 @@ public:
     // delete the record with the specified rid
     const Status deleteRecord(const RID & rid);
 
+    // squeeze out the holes left by deleted records; records move, so
+    // no pointer from getRecord may be in use
+    void compact();
+
     // returns RID of first record on page
     // returns  NORECORDS if page contains no records.  Otherwise, returns OK
     const Status firstRecord(RID& firstRid) const;
@@ -67,8 +168,33 @@ public:
     // returns ENDOFPAGE if no more records exist on the page
     const Status nextRecord (const RID & curRid, RID& nextRid) const;
 
-    // returns reference to record with RID rid
+    // returns reference to record with RID rid.  The records of a
+    // PAX page of more than one attribute are not kept whole, so
+    // INVALIDSLOTNO is returned for those; use the form below.
     const Status getRecord(const RID & rid, Record & rec);
+
+    // returns the record with RID rid in place if the page keeps it
+    // whole, otherwise put together in buf, which has room for
+    // PAGESIZE bytes
+    const Status getRecord(const RID & rid, Record & rec, char* buf) const;
+
+    // length bytes at offset of the record with RID rid, in place;
+    // NULL if there is no such record, the bytes go past its end, or
+    // they are not kept together (parts of two PAX attributes)
+    const char* getField(const RID & rid, const int offset,
+                         const int length) const;
+
+    // where length bytes at offset of every record of a PAX or fixed
+    // page are, those of slot slotNo at the pointer returned + slotNo *
+    // stride; NULL for a page of the row layout, or bytes that are not
+    // kept together.  Lets a scan find a field without looking it up
+    // for each record.
+    const char* getColumn(const int offset, const int length,
+                          int& stride) const
+      { return slotCnt > 0 ? paxColumn(offset, length, stride) : NULL; }
+
+    // length of the record with RID rid, 0 if there is none
+    int recordLength(const RID & rid) const;
 };
 
 #endif
@@ -57,6 +57,8 @@ typedef enum {
     N_LOAD,
     N_PRINT,
     N_HELP,
+    N_STATS,
+    N_RESIZE,
     N_SELECT,
     N_JOIN,
     N_PRIMATTR,
@@ -101,6 +103,8 @@ typedef struct node {
 	    char *relname;
 	    struct node *attrlist;
 	    struct node *primattr;
+	    char *layout;
+	    int compress;
 	} CREATE;
 
 	// destroy node */
@@ -137,6 +141,17 @@ typedef struct node {
 	    char *relname;
 	} HELP;
 
+	// stats node */
+	struct {
+	    char *relname;
+	    char *filename;
+	} STATS;
+
+	// resize node */
+	struct {
+	    int frames;
+	} RESIZE;
+
 	// select node */
 	struct {
 	    struct node *selattr;
@@ -215,7 +230,8 @@ NODE *newnode(int kind);
 NODE *query_node(char *relname, NODE *attrlist, NODE *n);
 NODE *insert_node(char *relname, NODE *attrlist);
 NODE *delete_node(char *relname, NODE *qual);
-NODE *create_node(char *relname, NODE *attrlist, NODE *primattr);
+NODE *create_node(char *relname, NODE *attrlist, NODE *primattr,
+		  char *layout, int compress);
 NODE *destroy_node(char *relname);
 NODE *build_node(char *relname, char *attrname, int nbuckets);
 NODE *rebuild_node(char *relname, char *attrname, int nbuckets);
@@ -223,6 +239,8 @@ NODE *drop_node(char *relname, char *attrname);
 NODE *load_node(char *relname, char *filename);
 NODE *print_node(char *relname);
 NODE *help_node(char *relname);
+NODE *stats_node(char *relname, char *filename);
+NODE *resize_node(int frames);
 NODE *select_node(NODE *selattr, int op, NODE *value);
 NODE *join_node(NODE *joinattr1, int op, NODE *joinattr2);
 NODE *qualattr_node(char *relname, char *attrname);
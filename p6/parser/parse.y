@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "heapfile.h"
+#include "wal.h"
 #include "parse.h"
 
 extern "C" int isatty(int);
@@ -72,10 +73,17 @@ static NODE *parse_tree;                // root of parse tree
 		T_QSTRING
 		T_SHELL_CMD
 
+%token		RW_STATS
+		RW_RESIZE
+		RW_LAYOUT
+		RW_COMPRESS
+
 %type	<ival>	op
+		opt_compress
 
 %type	<sval>	opt_into_relname
 		opt_relname
+		opt_layout
 		string
 
 %type	<n>	command
@@ -92,6 +100,8 @@ static NODE *parse_tree;                // root of parse tree
 		load
 		print
 		help
+		stats
+		resize
 		quit
 		opt_primary_attr
 		opt_where
@@ -155,6 +165,8 @@ command
 	| load
 	| print
 	| help
+	| stats
+	| resize
 	| quit
 	| nothing
 	{
@@ -257,8 +269,9 @@ delete
 
 create
 	: RW_CREATE RW_TABLE string '(' non_mt_attrtype_list ')' opt_primary_attr
+	  opt_layout opt_compress
 	{
-		$$ = create_node($3, $5, $7);
+		$$ = create_node($3, $5, $7, $8, $9);
 	}
 	;
 
@@ -316,6 +329,24 @@ help
 	}
 	;
 
+stats
+	: RW_STATS opt_relname
+	{
+		$$ = stats_node($2, NULL);
+	}
+	| RW_STATS RW_INTO T_QSTRING
+	{
+		$$ = stats_node(NULL, $3);
+	}
+	;
+
+resize
+	: RW_RESIZE T_INT
+	{
+		$$ = resize_node($2);
+	}
+	;
+
 quit
 	: RW_QUIT ';'
 	{
@@ -334,6 +365,28 @@ opt_primary_attr
 	}
 	;
 
+opt_layout
+	: RW_LAYOUT string
+	{
+		$$ = $2;
+	}
+	| nothing
+	{
+		$$ = NULL;
+	}
+	;
+
+opt_compress
+	: RW_COMPRESS
+	{
+		$$ = 1;
+	}
+	| nothing
+	{
+		$$ = 0;
+	}
+	;
+
 opt_into_relname
 	: RW_INTO string
 	{
@@ -529,9 +582,17 @@ void parse(void)
     printf("%s", PROMPT);
     fflush(stdout);
 
-    // if a query was successfully read, interpret it
-    if(yyparse() == 0 && parse_tree != NULL)
+    // if a query was successfully read, interpret it, then commit
+    // what it changed
+    if(yyparse() == 0 && parse_tree != NULL) {
       interp(parse_tree);
+
+      Status status;
+      if (wal && (status = wal->commit()) != OK) {
+        Error e;
+        e.print(status);
+      }
+    }
   }
 }
 
@@ -78,7 +78,11 @@
      T_REAL = 294,
      T_STRING = 295,
      T_QSTRING = 296,
-     T_SHELL_CMD = 297
+     T_SHELL_CMD = 297,
+     RW_STATS = 298,
+     RW_RESIZE = 299,
+     RW_LAYOUT = 300,
+     RW_COMPRESS = 301
    };
 #endif
 /* Tokens.  */
@@ -122,6 +126,10 @@
 #define T_STRING 295
 #define T_QSTRING 296
 #define T_SHELL_CMD 297
+#define RW_STATS 298
+#define RW_RESIZE 299
+#define RW_LAYOUT 300
+#define RW_COMPRESS 301
 
 
 
@@ -27,6 +27,11 @@ const Status UT_Load(const string & relation,
 
 const Status UT_Print(string relation);
 
+const Status UT_Stats(const string & relation,
+		      const string & fileName);
+
+const Status UT_Resize(const int frames);
+
 void   UT_Quit(void);
 
 #endif
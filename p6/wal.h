@@ -0,0 +1,167 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <sys/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "error.h"
+#include "page.h"
+#include "db.h"
+
+struct FileHdrPage;
+
+// Write-ahead log of changes to heap files.
+//
+// Every change HeapFile makes to a page is logged before the page can
+// be written back, as one of the records below.  The first change to
+// a page after a checkpoint logs an image of the page as it was, and
+// later changes are replayed on top of it, so replaying is the same
+// whatever state the page was in on disk.  The header page of a heap
+// file is imaged the same way, and then only its counts are logged
+// after each change.
+//
+// At the end of each statement commit() writes the log.  With a group
+// commit delay the log is synced by a thread of its own every delay
+// milliseconds, so one fdatasync covers all the statements that ended
+// in that time; with no delay every commit is synced before it
+// returns.  A page is never written back before the log records that
+// changed it are synced (see BufMgr, which asks syncTo()).
+//
+// Since the log has the changes, the dirty pages of files that DB
+// keeps open after they are closed need not be written until a
+// checkpoint; a file with logged changes that DB closes to make room
+// is synced first.  Once the log has grown past the checkpoint size,
+// the next commit writes all dirty pages, syncs the files and starts
+// the log afresh.  Recovery at startup replays the whole log and then
+// takes a checkpoint; a statement cut off by a crash is recovered as
+// far as its records reached the log.
+
+// the log, in the database directory; hidden so that a listing of the
+// directory shows the relations only
+#define WALFILE ".wal"
+
+const int WALGROUPMS = 5;       // default group commit delay
+const long WALCHECKPOINT = 8L << 20;  // default log size that forces a
+                                      // checkpoint
+
+enum WalType {
+  WAL_PAGE,                     // image of a page before its first change
+  WAL_INIT,                     // page initialized as an empty data page,
+                                // like the page whose start is logged
+  WAL_INSERT,                   // record inserted at slot
+  WAL_DELETE,                   // record at slot deleted
+  WAL_NEXT,                     // next page pointer set to arg
+  WAL_HEADER,                   // heap file header page, as far as used
+                                // (logs of earlier versions only)
+  WAL_CREATE,                   // heap file created, with pages like
+                                // the one whose start is logged,
+                                // compressed if arg is set
+  WAL_DESTROY,                  // heap file destroyed
+  WAL_COMMIT,                   // end of a statement
+  WAL_COUNTS                    // counts of a heap file header page and
+                                // the top of its free-space map
+};
+
+struct WalStats {
+  long records;                 // records logged
+  long bytes;                   // bytes logged
+  long images;                  // of them page images
+  int commits;
+  int syncs;                    // fdatasync calls on the log
+  int checkpoints;
+  int replayed;                 // records applied by recovery
+};
+
+class Wal
+{
+ public:
+  // open the log name in the current directory, making it if need be
+  Wal(const string & name, Status & status);
+  ~Wal();
+
+  // Replay the log left by the last run, then take a checkpoint.
+  // Logging is off until this has been done.
+  const Status recover();
+
+  // group commits delay ms apart; 0 syncs at every commit
+  void setGroupDelay(const int ms);
+  // take a checkpoint once the log is bytes long
+  void setCheckpointSize(const long bytes) { checkpointSize = bytes; }
+
+  bool logging() const { return active; }
+
+  // Log the image of pageNo of file unless it was logged since the
+  // last checkpoint.  Called before the page is changed.
+  void logPage(File* file, const int pageNo, const Page* page);
+  void logInit(File* file, const int pageNo, const Page* page);
+  void logInsert(File* file, const RID & rid, const Record & rec);
+  void logDelete(File* file, const RID & rid);
+  void logNext(File* file, const int pageNo, const int nextPage);
+  void logCounts(File* file, const int pageNo, const FileHdrPage* header);
+  void logCreate(File* file, const Page* format);
+  void logDestroy(const string & fileName);
+
+  // End of a statement: write out the log and sync it, now or with
+  // the next group; take a checkpoint if the log has grown too big.
+  const Status commit();
+
+  // write all dirty pages, sync the database files and truncate the log
+  const Status checkpoint();
+
+  // the position in the log just past the last record
+  long long endLsn() const { return appended; }
+
+  // make sure the log is on disk up to lsn
+  const Status syncTo(const long long lsn);
+
+  const WalStats getStats();
+
+ private:
+  void append(const WalType type, File* file, const string & fileName,
+              const int pageNo, const int arg, const char* data,
+              const int length);
+  const Status writeOut();      // write buf to the file; latch held
+  const Status apply(const int type, const string & fileName,
+                     const int pageNo, const int arg, const char* data,
+                     const int length);
+  const Status replayPage(File* file, const int pageNo, Page*& page);
+  void syncLoop();
+
+  int fd;                       // the log file
+  bool active;                  // recovered and logging
+
+  // Records are appended to buf and written at commits, when buf is
+  // full and before pages are written back.  LSNs count bytes logged
+  // since the log was made; the file holds those from start on.
+  mutex latch;                  // buf, written, start and imaged
+  vector<char> buf;
+  long long start;              // LSN of the first record in the file
+  atomic<long long> appended;   // LSN past the last record appended
+  long long written;            // LSN past the last record written
+  long long committed;          // LSN past the last commit record
+  atomic<long long> synced;     // LSN up to which the log is synced
+
+  // pages imaged since the last checkpoint
+  set<pair<string, int> > imaged;
+
+  mutex syncLatch;              // serializes fdatasync calls
+  long checkpointSize;
+
+  // group commit
+  int groupDelay;
+  thread* syncer;
+  bool stopSyncer;
+  condition_variable syncWake;
+
+  WalStats stats;               // updated with latch held
+  vector<File*> replayFiles;    // files opened by recover()
+};
+
+extern Wal* wal;                // NULL unless the database is logged
+
+#endif